@@ -0,0 +1,228 @@
+#!/bin/bash
+#
+# Benchmark for blame-warnings. Generates a synthetic Git repository and a synthetic compiler log and then times the
+# "--authorship" and "--loc" modes and the filter (with a cold and a warm blame cache). The repository and log depend only on
+# the settings below, so they're reused by later runs with the same settings, and timings from before and after a change to
+# blame-warnings can be compared on the same machine. Each run's "--stats" output is saved in the results directory.
+set -e
+
+arg0="${0##*/}"
+srcdir="$(cd "$(dirname "$0")" && pwd)"
+
+BINARY=                 # blame-warnings executable; empty means compile $srcdir/blame-warnings.C
+WORKDIR="${TMPDIR:-/tmp}/blame-warnings-bench"
+LOG_MB=2048             # approximate size of the compiler log in MiB
+DENSITY=10              # approximate warnings per 1000 lines of compiler log
+NFILES=2000             # number of source files in the repository
+NLINES=300              # lines per source file
+NAUTHORS=20             # number of authors
+NCOMMITS=50             # number of commits after the initial commit
+SWITCHES=()             # extra switches for every blame-warnings command
+
+usage() {
+    cat <<EOF
+usage: $arg0 [SWITCHES] [-- BLAME_WARNINGS_SWITCHES]
+
+Generates a synthetic Git repository and compiler log, then times blame-warnings.
+Switches after "--" are passed to every blame-warnings command, such as
+"-- --blame-lines" or "-- --jobs=4".
+
+  --binary=FILE     blame-warnings executable (default: compile blame-warnings.C
+                    from $srcdir with \$CXX and \$BOOST_ROOT)
+  --workdir=DIR     where the repository, log, and results go ($WORKDIR)
+  --log-size=MIB    approximate size of the compiler log ($LOG_MB)
+  --density=N       approximate warnings per 1000 lines of log ($DENSITY)
+  --files=N         number of source files ($NFILES)
+  --lines=N         lines per source file ($NLINES)
+  --authors=N       number of authors ($NAUTHORS)
+  --commits=N       number of commits after the first ($NCOMMITS)
+EOF
+}
+
+die() {
+    echo "$arg0: $*" >&2
+    exit 1
+}
+
+while [ "$#" -gt 0 ]; do
+    case "$1" in
+        -h|--help)   usage; exit 0 ;;
+        --binary=*)  BINARY="${1#--binary=}" ;;
+        --workdir=*) WORKDIR="${1#--workdir=}" ;;
+        --log-size=*) LOG_MB="${1#--log-size=}" ;;
+        --density=*) DENSITY="${1#--density=}" ;;
+        --files=*)   NFILES="${1#--files=}" ;;
+        --lines=*)   NLINES="${1#--lines=}" ;;
+        --authors=*) NAUTHORS="${1#--authors=}" ;;
+        --commits=*) NCOMMITS="${1#--commits=}" ;;
+        --)          shift; SWITCHES=("$@"); break ;;
+        *)           die "unknown switch \"$1\"; see --help" ;;
+    esac
+    shift
+done
+
+for n in "$LOG_MB" "$DENSITY" "$NFILES" "$NLINES" "$NAUTHORS" "$NCOMMITS"; do
+    [[ "$n" =~ ^[0-9]+$ ]] || die "\"$n\" is not a number"
+done
+[ "$NFILES" -gt 0 -a "$NLINES" -gt 0 -a "$NAUTHORS" -gt 0 ] || die "files, lines, and authors must be positive"
+[ "$DENSITY" -le 1000 ] || die "density cannot exceed 1000 warnings per 1000 lines"
+
+mkdir -p "$WORKDIR"
+WORKDIR="$(cd "$WORKDIR" && pwd)"
+REPO="$WORKDIR/repo"
+LOG="$WORKDIR/build.log"
+RESULTS="$WORKDIR/results"
+
+########################################################################################################################
+# The executable, compiled the same way as described at the top of blame-warnings.C
+if [ -z "$BINARY" ]; then
+    BINARY="$WORKDIR/blame-warnings"
+    if [ ! -x "$BINARY" -o "$srcdir/blame-warnings.C" -nt "$BINARY" ]; then
+        echo "$arg0: compiling $BINARY"
+        ${CXX:-c++} -Wall -g -O2 -pthread ${BOOST_ROOT:+-I$BOOST_ROOT/include} -o "$BINARY" \
+            "$srcdir/blame-warnings.C" ${BOOST_ROOT:+-Wl,-rpath,$BOOST_ROOT/lib -L$BOOST_ROOT/lib} \
+            -lboost_filesystem -lboost_regex -lboost_system
+    fi
+fi
+[ -x "$BINARY" ] || die "$BINARY is not executable"
+BINARY="$(cd "$(dirname "$BINARY")" && pwd)/$(basename "$BINARY")"
+
+########################################################################################################################
+# The repository. Files are src/dNN/fNNNNN.C. The initial commit creates them all, then each later commit, by one of the
+# authors, rewrites about a fifth of the lines in about a tenth of the files. Dates are fixed so the hashes are reproducible.
+repo_settings="files=$NFILES lines=$NLINES authors=$NAUTHORS commits=$NCOMMITS"
+if [ "$(cat "$REPO/.bench-settings" 2>/dev/null)" != "$repo_settings" ]; then
+    echo "$arg0: generating repository in $REPO ($repo_settings)"
+    rm -rf "$REPO"
+    mkdir -p "$REPO"
+    cd "$REPO"
+    git init -q .
+    awk -v nfiles="$NFILES" 'BEGIN { for (i = 0; i < nfiles; ++i) printf "src/d%02d\n", int(i / 50) }' |sort -u |xargs mkdir -p
+
+    commit() {
+        local author="$1" when="$2" message="$3"
+        git add -A
+        env GIT_AUTHOR_NAME="$author" GIT_AUTHOR_EMAIL="$(echo "$author" |tr 'A-Z ' 'a-z.')@example.com" \
+            GIT_COMMITTER_NAME="$author" GIT_COMMITTER_EMAIL="$(echo "$author" |tr 'A-Z ' 'a-z.')@example.com" \
+            GIT_AUTHOR_DATE="@$when +0000" GIT_COMMITTER_DATE="@$when +0000" \
+            git commit -q -m "$message"
+    }
+
+    awk -v nfiles="$NFILES" -v nlines="$NLINES" 'BEGIN {
+        for (i = 0; i < nfiles; ++i) {
+            f = sprintf("src/d%02d/f%05d.C", int(i / 50), i)
+            for (j = 1; j <= nlines; ++j)
+                printf "    int v%d = %d; // initial\n", j, i * j > f
+            close(f)
+        }
+    }'
+    commit "Author 0" 1600000000 "initial"
+
+    for c in $(seq 1 "$NCOMMITS"); do
+        awk -v nfiles="$NFILES" -v nlines="$NLINES" -v c="$c" 'BEGIN {
+            srand(c)
+            for (k = 0; k < nfiles / 10 || k < 1; ++k) {
+                i = int(rand() * nfiles)
+                f = sprintf("src/d%02d/f%05d.C", int(i / 50), i)
+                n = 0
+                while ((getline line <f) > 0)
+                    lines[++n] = line
+                close(f)
+                for (j = 1; j <= n; ++j) {
+                    if (rand() < 0.2)
+                        lines[j] = sprintf("    int v%d = %d; // commit %d", j, c * j, c)
+                    print lines[j] >f
+                }
+                close(f)
+            }
+        }'
+        commit "Author $((c % NAUTHORS))" $((1600000000 + c * 86400)) "commit $c"
+    done
+    echo "$repo_settings" >"$REPO/.bench-settings"
+    echo ".bench-settings" >"$REPO/.git/info/exclude"
+fi
+
+########################################################################################################################
+# The compiler log, which looks like libtool output from GNU make. Every source file is compiled, and warnings name a
+# random line of the file being compiled, with the GCC-style source excerpt after each warning.
+log_settings="size=$LOG_MB density=$DENSITY $repo_settings"
+if [ "$(cat "$LOG.settings" 2>/dev/null)" != "$log_settings" ]; then
+    echo "$arg0: generating $LOG ($log_settings)"
+    awk -v maxbytes="$((LOG_MB * 1048576))" -v density="$DENSITY" -v nfiles="$NFILES" -v nlines="$NLINES" -v q="'" '
+        function out(s) {
+            print s
+            nbytes += length(s) + 1
+        }
+        BEGIN {
+            srand(1)
+            while (nbytes < maxbytes) {
+                i = nfile++ % nfiles
+                dir = sprintf("src/d%02d", int(i / 50))
+                base = sprintf("f%05d", i)
+                if (0 == i % 50)
+                    out(sprintf("make[3]: Entering directory " q "/home/user/build/%s" q, dir))
+                out(sprintf("  CXX      %s.lo", base))
+                out(sprintf("libtool: compile:  g++ -DHAVE_CONFIG_H -I. -I../../../source/%s -I../../include -O2 -g -Wall -MT %s.lo -MD -MP -MF .deps/%s.Tpo -c ../../../source/%s/%s.C  -fPIC -DPIC -o .libs/%s.o", dir, base, base, dir, base, base))
+                for (k = 0; k < 20; ++k) {
+                    if (rand() * 1000 < density) {
+                        j = 1 + int(rand() * nlines)
+                        out(sprintf("../../../source/%s/%s.C:%d:9: warning: unused variable " q "v%d" q " [-Wunused-variable]", dir, base, j, j))
+                        out(sprintf("  %4d |     int v%d = %d;", j, j, j))
+                        out("       |         ^~")
+                    } else {
+                        out(sprintf("In file included from /usr/include/c++/12/bits/stl_algo.h:%d,", 60 + k))
+                    }
+                }
+                out(sprintf("mv -f .deps/%s.Tpo .deps/%s.Plo", base, base))
+            }
+        }' >"$LOG"
+    echo "$log_settings" >"$LOG.settings"
+fi
+
+########################################################################################################################
+# The benchmarks
+rm -rf "$RESULTS"
+mkdir -p "$RESULTS"
+log_bytes=$(wc -c <"$LOG")
+summary=()
+
+# Run one benchmark: NAME INPUT_FILE_OR_EMPTY BLAME_WARNINGS_SWITCHES...
+run() {
+    local name="$1" input="$2"
+    shift 2
+    local start end
+    echo "$arg0: running $name"
+    start=$(date +%s.%N)
+    if [ -n "$input" ]; then
+        (cd "$REPO" && "$BINARY" --stats "$@" "${SWITCHES[@]}" <"$input" >"$RESULTS/$name.out" 2>"$RESULTS/$name.stats")
+    else
+        (cd "$REPO" && "$BINARY" --stats "$@" "${SWITCHES[@]}" </dev/null >"$RESULTS/$name.out" 2>"$RESULTS/$name.stats")
+    fi || die "$name failed; see $RESULTS/$name.stats"
+    end=$(date +%s.%N)
+    if [ -n "$input" ]; then
+        summary+=("$(awk -v name="$name" -v t0="$start" -v t1="$end" -v bytes="$log_bytes" \
+            'BEGIN { t = t1 - t0; printf "%-24s %10.3f s %10.1f MiB/s", name, t, bytes / 1048576 / (t > 0 ? t : 1) }')")
+    else
+        summary+=("$(awk -v name="$name" -v t0="$start" -v t1="$end" 'BEGIN { printf "%-24s %10.3f s", name, t1 - t0 }')")
+    fi
+}
+
+# Start cold: no authorship database, blame cache, or saved file index.
+git_dir="$(git -C "$REPO" rev-parse --absolute-git-dir)"
+rm -rf "$REPO/.authorship" "$git_dir/blame-warnings" "$git_dir/blame-warnings-index"
+
+run authorship-text "" --authorship=. --authorship-format=text --no-blame-cache
+run authorship-unchanged "" --authorship=.
+run loc-text "" --loc=.
+run convert-binary "" --convert-authorship=binary
+run loc-binary "" --loc=.
+run filter-cold "$LOG"
+run filter-warm "$LOG"
+
+echo
+echo "$(wc -l <"$LOG") lines ($((log_bytes / 1048576)) MiB) of log with $DENSITY warnings per 1000 lines;" \
+     "$NFILES files of $NLINES lines; $NAUTHORS authors; $((NCOMMITS + 1)) commits"
+for line in "${summary[@]}"; do
+    echo "$line"
+done
+echo "Statistics for each run are in $RESULTS"